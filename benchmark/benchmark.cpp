@@ -2,40 +2,145 @@
 #include "lnutility.h"
 #include "protobuf/test.pb.h"
 #include "yas/record.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <latch>
+#include <new>
 #include <string>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
 
 #define LN_PP_STRING_IMPL(x) #x
 #define LN_PP_STRING(x)      LN_PP_STRING_IMPL(x)
 
+// 堆分配计数(按线程)，用于统计每个序列化器在计时循环中的分配次数
+static thread_local uint64_t benchmark_alloc_count = 0;
+
+// operator new 用 malloc 分配、operator delete 用 free 释放是有意配对的，GCC 内联后会误报
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(std::size_t size)
+{
+    benchmark_alloc_count++;
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void  operator delete(void* ptr) noexcept { std::free(ptr); }
+void  operator delete[](void* ptr) noexcept { std::free(ptr); }
+void  operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void  operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    benchmark_alloc_count++;
+    auto alignment = static_cast<std::size_t>(align);
+#if defined(_WIN32)
+    if (void* ptr = _aligned_malloc(size ? size : 1, alignment))
+        return ptr;
+#else
+    // aligned_alloc 要求大小是对齐的整数倍，向上取整前先排除溢出
+    if (size > SIZE_MAX - alignment)
+        throw std::bad_alloc();
+    if (void* ptr = std::aligned_alloc(alignment, (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment))
+        return ptr;
+#endif
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t align) { return ::operator new(size, align); }
+#if defined(_WIN32)
+void operator delete(void* ptr, std::align_val_t) noexcept { _aligned_free(ptr); }
+#else
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+#endif
+void operator delete[](void* ptr, std::align_val_t align) noexcept { ::operator delete(ptr, align); }
+void operator delete(void* ptr, std::size_t, std::align_val_t align) noexcept { ::operator delete(ptr, align); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t align) noexcept { ::operator delete(ptr, align); }
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+struct lnserializerTinyRecord
+{
+    uint64_t  id        = 0;
+    uint64_t  timestamp = 0;
+    float64_t price     = 0;
+    uint32_t  quantity  = 0;
+    uint32_t  flags     = 0;
+
+    bool operator==(const lnserializerTinyRecord&) const = default;
+};
+LN_TYPE_INFO_FIELDS_DECL(lnserializerTinyRecord, id, timestamp, price, quantity, flags);
+
 struct benchmark_data
 {
-    std::vector<uint64_t>     ints;
-    std::vector<float64_t>   floats;
-    std::vector<std::string> strs;
-    uint64_t                 count;
+    std::vector<uint64_t>               ints;
+    std::vector<float64_t>              floats;
+    std::vector<std::string>            strs;
+    std::vector<lnserializerTinyRecord> records; // 各线程共享，只读
+    uint64_t                            count;
+    size_t                              threads     = 1;
+    std::latch*                         start_latch = nullptr; // 多线程运行时的开始屏障
 };
 
+// 当前线程是否已经到达开始屏障
+static thread_local bool benchmark_started = false;
+
+// 多线程运行时，等所有线程都完成准备后再一起进入计时循环
+void benchmark_wait_start(benchmark_data& data)
+{
+    benchmark_started = true;
+    if (data.start_latch)
+        data.start_latch->arrive_and_wait();
+}
+
 struct benchmark_result
 {
-    benchmark_result(std::string name, std::string version, size_t size, uint64_t time)
-        : name(name), version(version), size(size), time(time)
+    benchmark_result(std::string name, std::string version, size_t size, uint64_t time, uint64_t allocs)
+        : name(name), version(version), size(size), time(time), allocs(allocs)
     {
     }
 
     std::string name;
     std::string version;
-    size_t      size = 0;
-    uint64_t    time = 0;
+    size_t      size          = 0;
+    uint64_t    time          = 0;
+    uint64_t    allocs        = 0;                          // 计时循环中的堆分配次数
+    uint64_t    steady_allocs = static_cast<uint64_t>(-1); // 预热后单次往返的堆分配次数，-1 表示未测量
+    size_t      buffer        = static_cast<size_t>(-1);   // 序列化时内存中缓冲区的容量，-1 表示未测量
 };
 
 enum class benchmark_type_e : int
 {
-    LN_STRING,  // 字符串
-    LN_INTEGER, // 整数
-    LN_FLOAT,   // 浮点数
-    LN_ALL,     //
+    LN_STRING,    // 字符串
+    LN_INTEGER,   // 整数
+    LN_FLOAT,     // 浮点数
+    LN_ALL,       //
+    LN_SMALL,     // 小消息
+    LN_SNAPSHOT,  // 大快照写入和读取文件
+    LN_SHARED,    // 多线程共享缓冲区反序列化
+    LN_RECORDS,   // 大量小记录
+    LN_TRADES,    // 结构体数组与按列存储
+    LN_TIMESTAMP, // 有序时间戳
+    LN_SERIES,    // 浮点时间序列
+    LN_STATUS,    // 小范围整数(状态码)
 };
 
+// 固定种子的线性同余随机数，保证每次运行生成相同的数据集
+uint64_t benchmark_rand(uint64_t& seed)
+{
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return seed;
+}
+
 void benchmark_data_init(benchmark_data& data, benchmark_type_e type)
 {
     if (type == benchmark_type_e::LN_STRING || type == benchmark_type_e::LN_ALL)
@@ -63,6 +168,126 @@ void benchmark_data_init(benchmark_data& data, benchmark_type_e type)
             data.floats.push_back(f);
         }
     }
+
+    if (type == benchmark_type_e::LN_TIMESTAMP)
+    {
+        // 毫秒时间戳，间隔在 1~64ms 之间抖动
+        uint64_t timestamp = 1700000000000;
+        uint64_t seed      = 1;
+        for (int i = 0; i < 4096; i++)
+        {
+            timestamp += 1 + (benchmark_rand(seed) >> 58);
+            data.ints.push_back(timestamp);
+        }
+    }
+
+    if (type == benchmark_type_e::LN_SERIES)
+    {
+        // 每秒采样的温度，缓慢变化加少量噪声，按传感器精度保留两位小数
+        uint64_t seed = 1;
+        for (int i = 0; i < 4096; i++)
+        {
+            float64_t noise = static_cast<float64_t>(benchmark_rand(seed) >> 54) / 1024 - 0.5;
+            float64_t value = 20.0 + 5.0 * std::sin(i / 600.0) + 0.2 * noise;
+            data.floats.push_back(std::round(value * 100) / 100);
+        }
+    }
+
+    if (type == benchmark_type_e::LN_STATUS)
+    {
+        // 以 uint64_t 保存的状态码，大部分为 200
+        const uint64_t codes[] = {200, 200, 200, 200, 200, 200, 201, 204, 304, 400, 404, 500};
+        uint64_t       seed    = 1;
+        for (int i = 0; i < 4096; i++)
+        {
+            data.ints.push_back(codes[(benchmark_rand(seed) >> 33) % std::size(codes)]);
+        }
+    }
+
+    if (type == benchmark_type_e::LN_SNAPSHOT)
+    {
+        // data.count 条 1KB 的字符串，count 为 1048576 时约 1GB
+        for (uint64_t i = 0; i < data.count; i++)
+        {
+            data.strs.push_back(std::string(1024, static_cast<char>('a' + i % 26)));
+        }
+    }
+
+    if (type == benchmark_type_e::LN_RECORDS || type == benchmark_type_e::LN_TRADES)
+    {
+        // 32 字节的记录，LN_RECORDS 为 data.count 条，LN_TRADES 固定 4096 条
+        data.records.resize(type == benchmark_type_e::LN_RECORDS ? data.count : 4096);
+        for (size_t i = 0; i < data.records.size(); i++)
+        {
+            data.records[i].id        = i;
+            data.records[i].timestamp = 1700000000000 + i * 10;
+            data.records[i].price     = 100.0 + static_cast<float64_t>(i % 1000) / 100;
+            data.records[i].quantity  = static_cast<uint32_t>(i % 500);
+            data.records[i].flags     = static_cast<uint32_t>(i & 0xf);
+        }
+    }
+}
+
+// 在 data.threads 个线程上同时运行同一个用例，各线程完成准备后一起开始计时，
+// time 取最慢的线程，allocs 为各线程之和，steady_allocs 取最大值(同一用例要么都测量要么都未测量)
+template <typename Func>
+benchmark_result benchmark_run(Func func, benchmark_data& data)
+{
+    if (data.threads <= 1)
+        return func(data);
+
+    std::latch start_latch(static_cast<std::ptrdiff_t>(data.threads));
+    data.start_latch = &start_latch;
+    auto worker      = [&]() {
+        benchmark_started = false;
+        try
+        {
+            return func(data);
+        }
+        catch (...)
+        {
+            // 准备阶段失败时也要到达屏障，避免其他线程一直等待
+            if (!benchmark_started)
+                start_latch.count_down();
+            throw;
+        }
+    };
+
+    std::vector<std::future<benchmark_result>> futures;
+    futures.reserve(data.threads);
+    try
+    {
+        for (size_t i = 0; i < data.threads; i++)
+        {
+            futures.push_back(std::async(std::launch::async, worker));
+        }
+    }
+    catch (...)
+    {
+        // 线程创建失败时，替未启动的线程到达屏障，让已启动的线程能够结束
+        start_latch.count_down(static_cast<std::ptrdiff_t>(data.threads - futures.size()));
+        for (auto& future : futures)
+        {
+            future.wait();
+        }
+        data.start_latch = nullptr;
+        throw;
+    }
+    for (auto& future : futures)
+    {
+        future.wait();
+    }
+    data.start_latch = nullptr;
+
+    benchmark_result result = futures[0].get();
+    for (size_t i = 1; i < futures.size(); i++)
+    {
+        benchmark_result other = futures[i].get();
+        result.time = std::max(result.time, other.time);
+        result.allocs += other.allocs;
+        result.steady_allocs = std::max(result.steady_allocs, other.steady_allocs);
+    }
+    return result;
 }
 
 benchmark_result benchmark_protobuf_serialization(benchmark_data& data)
@@ -106,7 +331,9 @@ benchmark_result benchmark_protobuf_serialization(benchmark_data& data)
             throw std::logic_error("protobuf's case: deserialization failed : floats");
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
+    benchmark_wait_start(data);
+    auto allocs = benchmark_alloc_count;
+    auto start  = std::chrono::high_resolution_clock::now();
     for (size_t i = 0; i < data.count; i++)
     {
         serialized.clear();
@@ -115,7 +342,8 @@ benchmark_result benchmark_protobuf_serialization(benchmark_data& data)
     }
     auto finish   = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
-    return benchmark_result("protobuf", LN_PP_STRING(GOOGLE_PROTOBUF_VERSION), serialized.size(), duration);
+    allocs        = benchmark_alloc_count - allocs;
+    return benchmark_result("protobuf", LN_PP_STRING(GOOGLE_PROTOBUF_VERSION), serialized.size(), duration, allocs);
 }
 
 struct lnserializerRecord
@@ -130,6 +358,14 @@ struct lnserializerRecord
 };
 LN_TYPE_INFO_FIELDS_DECL(lnserializerRecord, ids, floats, strings);
 
+template <std::size_t opts>
+std::string lnserializer_tag()
+{
+    if (opts & ln::serialization_options::LN_COMPACTED)
+        return "lnserializer-compact";
+    return "lnserializer";
+}
+
 template <std::size_t opts>
 benchmark_result benchmark_lnserializer_serialization(benchmark_data& data)
 {
@@ -155,17 +391,322 @@ benchmark_result benchmark_lnserializer_serialization(benchmark_data& data)
     if (r1.floats != r2.floats)
         throw std::logic_error("lnserializer's case: deserialization failed : floats");
 
-    std::string tag;
-    if (opts & serialization_options::LN_COMPACTED)
+    // r2 和 serialized 已经预热，统计再往返一次的堆分配次数，复用已有容量时应为 0
+    auto steady_allocs = benchmark_alloc_count;
+    serialized.cont.clear();
+    serialized.offset = 0;
+    serialized << r1;
+    serialized >> r2;
+    steady_allocs = benchmark_alloc_count - steady_allocs;
+#if defined(LN_BENCHMARK_CHECK_STEADY_ALLOCS)
+    if (steady_allocs != 0)
+        throw std::logic_error("lnserializer's case: steady-state round-trip allocated");
+#endif
+
+    benchmark_wait_start(data);
+    auto allocs = benchmark_alloc_count;
+    auto start  = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < data.count; i++)
     {
-        tag = "lnserializer-compact";
+        serialized.cont.clear();
+        serialized.offset = 0;
+        serialized << r1;
+        serialized >> r2;
     }
-    else
+    auto finish   = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+    allocs        = benchmark_alloc_count - allocs;
+
+    benchmark_result result(lnserializer_tag<opts>(), LN_SERIALIZER_VERSION, serialized.size(), duration, allocs);
+    result.steady_allocs = steady_allocs;
+    return result;
+}
+
+// 先完整序列化到内存，再一次写入文件，峰值内存至少为整个消息的大小
+template <std::size_t opts>
+benchmark_result benchmark_lnserializer_fwrite_serialization(benchmark_data& data)
+{
+    using namespace ln;
+    using container_t = serialization_container<std::string, opts>;
+
+    std::FILE* file = std::tmpfile();
+    if (file == nullptr)
+        throw std::runtime_error("lnserializer's fwrite case: tmpfile failed");
+
+    // 借用数据集中的字符串，避免再复制一份
+    lnserializerRecord r1;
+    r1.strings.swap(data.strs);
+
+    size_t size    = 0;
+    size_t buffer  = 0;
+    size_t written = 0;
+    auto   allocs  = benchmark_alloc_count;
+    auto   start   = std::chrono::high_resolution_clock::now();
+    {
+        container_t serialized;
+        serialized << r1;
+        size    = serialized.cont.size();
+        buffer  = serialized.cont.capacity();
+        written = std::fwrite(serialized.cont.data(), 1, size, file);
+        std::fflush(file);
+    }
+    auto finish   = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+    allocs        = benchmark_alloc_count - allocs;
+
+    std::fclose(file);
+    r1.strings.swap(data.strs);
+    if (written != size)
+        throw std::logic_error("lnserializer's fwrite case: write failed");
+
+    benchmark_result result(lnserializer_tag<opts>() + "-fwrite", LN_SERIALIZER_VERSION, size, duration, allocs);
+    result.buffer = buffer;
+    return result;
+}
+
+// 当前的快照加载方式：把文件整个读入 std::string 再反序列化。文件刚写入，仍在页缓存中，
+// 所以这里测到的是读入复制和反序列化的开销，真正的冷启动还需先清空页缓存
+template <std::size_t opts>
+benchmark_result benchmark_lnserializer_fread_deserialization(benchmark_data& data)
+{
+    using namespace ln;
+    using container_t = serialization_container<std::string, opts>;
+
+    std::FILE* file = std::tmpfile();
+    if (file == nullptr)
+        throw std::runtime_error("lnserializer's fread case: tmpfile failed");
+
+    size_t size    = 0;
+    size_t written = 0;
+    {
+        lnserializerRecord r1;
+        r1.strings.swap(data.strs);
+        container_t serialized;
+        serialized << r1;
+        size    = serialized.cont.size();
+        written = std::fwrite(serialized.cont.data(), 1, size, file);
+        std::fflush(file);
+        r1.strings.swap(data.strs);
+    }
+    if (written != size)
     {
-        tag = "lnserializer";
+        std::fclose(file);
+        throw std::logic_error("lnserializer's fread case: write failed");
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
+    lnserializerRecord r2;
+    size_t             read   = 0;
+    size_t             offset = 0;
+    auto               allocs = benchmark_alloc_count;
+    auto               start  = std::chrono::high_resolution_clock::now();
+    {
+        container_t snapshot;
+        std::rewind(file);
+        snapshot.cont.resize(size);
+        read = std::fread(snapshot.cont.data(), 1, size, file);
+        snapshot >> r2;
+        offset = snapshot.offset;
+    }
+    auto finish   = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+    allocs        = benchmark_alloc_count - allocs;
+
+    std::fclose(file);
+    if (read != size || offset == static_cast<size_t>(-1))
+        throw std::logic_error("lnserializer's fread case: deserialization failed");
+    if (r2.strings != data.strs)
+        throw std::logic_error("lnserializer's fread case: deserialization failed : strings");
+    return benchmark_result(lnserializer_tag<opts>() + "-fread", LN_SERIALIZER_VERSION, size, duration, allocs);
+}
+
+// 多个线程反序列化同一个缓冲区。偏移量在容器中，所以每个线程每次都要先复制缓冲区，
+// 测到的是复制加反序列化的开销，只作为共享缓冲区反序列化的基线
+template <std::size_t opts>
+benchmark_result benchmark_lnserializer_shared_deserialization(benchmark_data& data)
+{
+    using namespace ln;
+    using container_t = serialization_container<std::string, opts>;
+
+    lnserializerRecord r1;
+    r1.ids     = data.ints;
+    r1.strings = data.strs;
+    r1.floats  = data.floats;
+
+    container_t serialized;
+    serialized << r1;
+    const std::string& shared = serialized.cont;
+
+    // 每个线程各自预热和计时，由 benchmark_run 汇总
+    auto decode = [&r1, &shared](benchmark_data& thread_data) -> benchmark_result {
+        container_t        reader;
+        lnserializerRecord r2;
+        reader.cont.assign(shared);
+        reader >> r2;
+
+        if (reader.offset == static_cast<size_t>(-1))
+            throw std::logic_error("lnserializer's shared case: deserialization failed");
+        if (r1.ids != r2.ids || r1.strings != r2.strings || r1.floats != r2.floats)
+            throw std::logic_error("lnserializer's shared case: deserialization failed : fields");
+
+        benchmark_wait_start(thread_data);
+        auto allocs = benchmark_alloc_count;
+        auto start  = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < thread_data.count; i++)
+        {
+            reader.cont.assign(shared);
+            reader.offset = 0;
+            reader >> r2;
+        }
+        auto finish   = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+        allocs        = benchmark_alloc_count - allocs;
+
+        if (reader.offset == static_cast<size_t>(-1))
+            throw std::logic_error("lnserializer's shared case: deserialization failed");
+        return benchmark_result(lnserializer_tag<opts>() + "-copy", LN_SERIALIZER_VERSION, shared.size(), duration, allocs);
+    };
+    return benchmark_run(decode, data);
+}
+
+struct lnserializerSmallRecord
+{
+    uint64_t    id    = 0;
+    uint32_t    code  = 0;
+    float64_t   value = 0;
+    std::string name;
+};
+LN_TYPE_INFO_FIELDS_DECL(lnserializerSmallRecord, id, code, value, name);
+
+// 小消息往返，每次使用新的容器，time 为单次序列化和反序列化的纳秒数
+template <std::size_t opts>
+benchmark_result benchmark_lnserializer_small_serialization(benchmark_data& data)
+{
+    using namespace ln;
+    using container_t = serialization_container<std::string, opts>;
+
+    lnserializerSmallRecord r1;
+    r1.id    = 1001;
+    r1.code  = 200;
+    r1.value = 3.1415926;
+    r1.name  = "order";
+
+    container_t serialized;
+    serialized << r1;
+    lnserializerSmallRecord r2;
+    serialized >> r2;
+
+    if (serialized.offset == static_cast<size_t>(-1))
+        throw std::logic_error("lnserializer's small case: deserialization failed");
+    if (r1.id != r2.id || r1.code != r2.code || r1.value != r2.value || r1.name != r2.name)
+        throw std::logic_error("lnserializer's small case: deserialization failed : fields");
+
+    benchmark_wait_start(data);
+    auto allocs = benchmark_alloc_count;
+    auto start  = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < data.count; i++)
+    {
+        container_t message;
+        message << r1;
+        message >> r2;
+    }
+    auto finish   = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count();
+    allocs        = benchmark_alloc_count - allocs;
+    return benchmark_result(lnserializer_tag<opts>(), LN_SERIALIZER_VERSION, serialized.size(), data.count ? duration / data.count : 0, allocs);
+}
+
+// 逐条序列化和反序列化 data.records 中的记录，size 为所有记录的总字节数
+template <std::size_t opts>
+benchmark_result benchmark_lnserializer_records_serialization(benchmark_data& data)
+{
+    using namespace ln;
+    using container_t = serialization_container<std::string, opts>;
+
+    const auto& records = data.records;
+
+    container_t            serialized;
+    lnserializerTinyRecord decoded;
+    size_t                 size   = 0;
+    bool                   failed = false;
+
+    // 先往返一次第一条记录，让容器完成首次扩容
+    if (!records.empty())
+    {
+        const auto& first = records.front();
+        serialized << first;
+        serialized >> decoded;
+
+        if (serialized.offset == static_cast<size_t>(-1))
+            throw std::logic_error("lnserializer's records case: deserialization failed");
+        if (decoded.id != first.id || decoded.timestamp != first.timestamp || decoded.price != first.price
+            || decoded.quantity != first.quantity || decoded.flags != first.flags)
+            throw std::logic_error("lnserializer's records case: deserialization failed : fields");
+    }
+
+    benchmark_wait_start(data);
+    auto allocs = benchmark_alloc_count;
+    auto start  = std::chrono::high_resolution_clock::now();
+    for (const auto& record : records)
+    {
+        serialized.cont.clear();
+        serialized.offset = 0;
+        serialized << record;
+        serialized >> decoded;
+        size += serialized.size();
+        failed |= serialized.offset == static_cast<size_t>(-1);
+    }
+    auto finish   = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+    allocs        = benchmark_alloc_count - allocs;
+
+    if (failed)
+        throw std::logic_error("lnserializer's records case: deserialization failed");
+    if (!records.empty() && (decoded.id != records.back().id || decoded.timestamp != records.back().timestamp))
+        throw std::logic_error("lnserializer's records case: deserialization failed : fields");
+    return benchmark_result(lnserializer_tag<opts>(), LN_SERIALIZER_VERSION, size, duration, allocs);
+}
+
+struct lnserializerTradesRecord
+{
+    std::vector<lnserializerTinyRecord> trades;
+
+    bool operator==(const lnserializerTradesRecord&) const = default;
+};
+LN_TYPE_INFO_FIELDS_DECL(lnserializerTradesRecord, trades);
+
+// 与 lnserializerTradesRecord 相同的数据，手工按列存储
+struct lnserializerTradeColumnsRecord
+{
+    std::vector<uint64_t>  ids;
+    std::vector<uint64_t>  timestamps;
+    std::vector<float64_t> prices;
+    std::vector<uint32_t>  quantities;
+    std::vector<uint32_t>  flags;
+
+    bool operator==(const lnserializerTradeColumnsRecord&) const = default;
+};
+LN_TYPE_INFO_FIELDS_DECL(lnserializerTradeColumnsRecord, ids, timestamps, prices, quantities, flags);
+
+// 反复序列化和反序列化同一条消息，layout 用于区分同一批数据的不同布局
+template <std::size_t opts, typename T>
+benchmark_result benchmark_lnserializer_layout_serialization(benchmark_data& data, const T& r1, const std::string& layout)
+{
+    using namespace ln;
+    using container_t = serialization_container<std::string, opts>;
+
+    container_t serialized;
+    serialized << r1;
+    T r2;
+    serialized >> r2;
+
+    if (serialized.offset == static_cast<size_t>(-1))
+        throw std::logic_error("lnserializer's " + layout + " case: deserialization failed");
+    if (!(r1 == r2))
+        throw std::logic_error("lnserializer's " + layout + " case: deserialization failed : fields");
+
+    benchmark_wait_start(data);
+    auto allocs = benchmark_alloc_count;
+    auto start  = std::chrono::high_resolution_clock::now();
     for (size_t i = 0; i < data.count; i++)
     {
         serialized.cont.clear();
@@ -175,7 +716,33 @@ benchmark_result benchmark_lnserializer_serialization(benchmark_data& data)
     }
     auto finish   = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
-    return benchmark_result(tag, LN_SERIALIZER_VERSION, serialized.size(), duration);
+    allocs        = benchmark_alloc_count - allocs;
+    return benchmark_result(lnserializer_tag<opts>() + "-" + layout, LN_SERIALIZER_VERSION, serialized.size(), duration, allocs);
+}
+
+// std::vector 中的结构体逐个交错写出各字段
+template <std::size_t opts>
+benchmark_result benchmark_lnserializer_aos_serialization(benchmark_data& data)
+{
+    lnserializerTradesRecord r1;
+    r1.trades = data.records;
+    return benchmark_lnserializer_layout_serialization<opts>(data, r1, "aos");
+}
+
+// 同样的数据拆成每个字段一个连续数组，是按列编码要达到的目标
+template <std::size_t opts>
+benchmark_result benchmark_lnserializer_soa_serialization(benchmark_data& data)
+{
+    lnserializerTradeColumnsRecord r1;
+    for (const auto& record : data.records)
+    {
+        r1.ids.push_back(record.id);
+        r1.timestamps.push_back(record.timestamp);
+        r1.prices.push_back(record.price);
+        r1.quantities.push_back(record.quantity);
+        r1.flags.push_back(record.flags);
+    }
+    return benchmark_lnserializer_layout_serialization<opts>(data, r1, "soa");
 }
 
 template <std::size_t opts>
@@ -210,7 +777,9 @@ benchmark_result benchmark_yas_serialization(benchmark_data& data)
         tag = "yas";
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
+    benchmark_wait_start(data);
+    auto allocs = benchmark_alloc_count;
+    auto start  = std::chrono::high_resolution_clock::now();
     for (size_t i = 0; i < data.count; i++)
     {
         serialized.clear();
@@ -219,8 +788,9 @@ benchmark_result benchmark_yas_serialization(benchmark_data& data)
     }
     auto finish   = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+    allocs        = benchmark_alloc_count - allocs;
 
-    return benchmark_result(tag, YAS_VERSION_STRING, serialized.size(), duration);
+    return benchmark_result(tag, YAS_VERSION_STRING, serialized.size(), duration, allocs);
 }
 
 benchmark_result benchmark_cereal_serialization(benchmark_data& data)
@@ -243,7 +813,9 @@ benchmark_result benchmark_cereal_serialization(benchmark_data& data)
         throw std::logic_error("cereal's case: deserialization failed");
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
+    benchmark_wait_start(data);
+    auto allocs = benchmark_alloc_count;
+    auto start  = std::chrono::high_resolution_clock::now();
     for (size_t i = 0; i < data.count; i++)
     {
         serialized.clear();
@@ -252,35 +824,112 @@ benchmark_result benchmark_cereal_serialization(benchmark_data& data)
     }
     auto finish   = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+    allocs        = benchmark_alloc_count - allocs;
 
-    return benchmark_result("cereal", "1.3.2", serialized.size(), duration);
+    return benchmark_result("cereal", "1.3.2", serialized.size(), duration, allocs);
 }
 
 //
 int main(int argc, char** argv)
 {
-    int            benchmark_type = std::stoi(argv[1]);
-    size_t         count          = std::stoull(argv[2]);
-    benchmark_data data;
-    benchmark_data_init(data, static_cast<benchmark_type_e>(benchmark_type));
-    data.count = count;
+    int              benchmark_type = std::stoi(argv[1]);
+    size_t           count          = std::stoull(argv[2]);
+    size_t           threads        = argc > 3 ? std::stoull(argv[3]) : 1;
+    benchmark_type_e type           = static_cast<benchmark_type_e>(benchmark_type);
+    benchmark_data   data;
+    data.count   = count;
+    data.threads = threads;
+    benchmark_data_init(data, type == benchmark_type_e::LN_SHARED ? benchmark_type_e::LN_ALL : type);
     std::vector<benchmark_result> results;
-    results.push_back(benchmark_protobuf_serialization(data));
-    results.push_back(benchmark_lnserializer_serialization<
-                      ln::serialization_options::LN_BINARY
-                      | ln::serialization_options::LN_NO_HEADER>(data));
-    results.push_back(benchmark_lnserializer_serialization<
-                      ln::serialization_options::LN_BINARY
-                      | ln::serialization_options::LN_NO_HEADER
-                      | ln::serialization_options::LN_COMPACTED>(data));
-    results.push_back(benchmark_yas_serialization<yas::binary | yas::no_header>(data));
-    results.push_back(benchmark_yas_serialization<yas::binary | yas::no_header | yas::compacted>(data));
-    results.push_back(benchmark_cereal_serialization(data));
-
-    std::cout << "serializer\tversion\tcount\tsize\ttime" << std::endl;
+    std::string                   count_label = "count";
+    std::string                   time_label  = "time";
+    if (type == benchmark_type_e::LN_SMALL)
+    {
+        time_label = "ns/op";
+        results.push_back(benchmark_run(benchmark_lnserializer_small_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER>, data));
+        results.push_back(benchmark_run(benchmark_lnserializer_small_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER
+                          | ln::serialization_options::LN_COMPACTED>, data));
+    }
+    else if (type == benchmark_type_e::LN_SHARED)
+    {
+        // 各线程共享同一个缓冲区，用例内部通过 benchmark_run 运行
+        results.push_back(benchmark_lnserializer_shared_deserialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER>(data));
+        results.push_back(benchmark_lnserializer_shared_deserialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER
+                          | ln::serialization_options::LN_COMPACTED>(data));
+    }
+    else if (type == benchmark_type_e::LN_RECORDS)
+    {
+        // count 为记录条数，每条记录只往返一次
+        count_label = "records";
+        results.push_back(benchmark_run(benchmark_lnserializer_records_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER>, data));
+        results.push_back(benchmark_run(benchmark_lnserializer_records_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER
+                          | ln::serialization_options::LN_COMPACTED>, data));
+    }
+    else if (type == benchmark_type_e::LN_TRADES)
+    {
+        results.push_back(benchmark_run(benchmark_lnserializer_aos_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER>, data));
+        results.push_back(benchmark_run(benchmark_lnserializer_soa_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER>, data));
+        results.push_back(benchmark_run(benchmark_lnserializer_aos_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER
+                          | ln::serialization_options::LN_COMPACTED>, data));
+        results.push_back(benchmark_run(benchmark_lnserializer_soa_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER
+                          | ln::serialization_options::LN_COMPACTED>, data));
+    }
+    else if (type == benchmark_type_e::LN_SNAPSHOT)
+    {
+        // 单次运行的文件读写基线，不经过 benchmark_run，count 为字符串条数，time 为毫秒
+        count_label = "strings";
+        results.push_back(benchmark_lnserializer_fwrite_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER>(data));
+        results.push_back(benchmark_lnserializer_fread_deserialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER>(data));
+    }
+    else
+    {
+        results.push_back(benchmark_run(benchmark_protobuf_serialization, data));
+        results.push_back(benchmark_run(benchmark_lnserializer_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER>, data));
+        results.push_back(benchmark_run(benchmark_lnserializer_serialization<
+                          ln::serialization_options::LN_BINARY
+                          | ln::serialization_options::LN_NO_HEADER
+                          | ln::serialization_options::LN_COMPACTED>, data));
+        results.push_back(benchmark_run(benchmark_yas_serialization<yas::binary | yas::no_header>, data));
+        results.push_back(benchmark_run(benchmark_yas_serialization<yas::binary | yas::no_header | yas::compacted>, data));
+        results.push_back(benchmark_run(benchmark_cereal_serialization, data));
+    }
+
+    std::cout << "serializer\tversion\t" << count_label << "\tsize\t" << time_label << "\tallocs\tsteady allocs\tbuffer" << std::endl;
     for (const auto& result : results)
     {
-        std::cout << result.name << "\t" << result.version << "\t" << count << "\t" << result.size << "\t" << result.time << std::endl;
+        std::string steady_allocs = "-";
+        if (result.steady_allocs != static_cast<uint64_t>(-1))
+            steady_allocs = std::to_string(result.steady_allocs);
+        std::string buffer = "-";
+        if (result.buffer != static_cast<size_t>(-1))
+            buffer = std::to_string(result.buffer);
+        std::cout << result.name << "\t" << result.version << "\t" << count << "\t" << result.size << "\t" << result.time << "\t" << result.allocs << "\t" << steady_allocs << "\t" << buffer << std::endl;
     }
 
     //for (const auto& result : results)